@@ -0,0 +1,487 @@
+#ifndef DIGRAPH_ANALYTICS_H_INCLUDED__
+#define DIGRAPH_ANALYTICS_H_INCLUDED__
+
+#include <digraph/digraph.h>
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cmath>
+#include <cstddef>
+
+namespace digraph
+{
+
+namespace detail
+{
+
+// minimum number of vertices handed to a worker when the thread count is chosen automatically
+constexpr size_t parallel_grain_size = 4096;
+
+// the automatic choice is bounded by the hardware threads, explicit requests only by the work
+inline size_t thread_count( size_t requested, size_t work )
+{
+    size_t threads = requested;
+    if (threads == 0) {
+        threads = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+        threads = std::min( threads, (work + parallel_grain_size - 1) / parallel_grain_size );
+    }
+    return std::max<size_t>( std::min( threads, work ), 1 );
+}
+
+// reusable rendezvous point for a fixed number of threads
+class barrier
+{
+public:
+    explicit barrier( size_t count ) : _count( count ), _waiting( 0 ), _generation( 0 ) {}
+
+    void arrive_and_wait()
+    {
+        std::unique_lock<std::mutex> lock( _mutex );
+        const size_t generation = _generation;
+        if (++_waiting == _count) {
+            _waiting = 0;
+            ++_generation;
+            _cv.notify_all();
+            return;
+        }
+        _cv.wait( lock, [&]() { return generation != _generation; } );
+    }
+
+private:
+    std::mutex              _mutex;
+    std::condition_variable _cv;
+    const size_t            _count;
+    size_t                  _waiting;
+    size_t                  _generation;
+};
+
+// calls f( begin, end, chunk ) for [0,size) split into threads contiguous chunks,
+// the first chunk runs on the calling thread
+template<class F>
+inline void parallel_for( size_t size, size_t threads, F f )
+{
+    const size_t chunk = (size + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve( threads - 1 );
+    for (size_t t = 1; t < threads; ++t) {
+        const size_t begin = std::min( t * chunk, size );
+        const size_t end = std::min( begin + chunk, size );
+        workers.emplace_back( f, begin, end, t );
+    }
+    f( size_t( 0 ), std::min( chunk, size ), size_t( 0 ) );
+    for (auto& w : workers) w.join();
+}
+
+}
+
+// Immutable compressed sparse row snapshot of a digraph. Vertices are numbered
+// 0..num_vertices()-1 and every result of the analytics kernels is indexed by these
+// CSR ids. If the graph uses dense vertex storage and its ids are exactly
+// 0..num_vertices()-1, the CSR id of a vertex is its own id and id() is an identity,
+// otherwise ids follow the iteration order of digraph::vertices() and have to be
+// translated with id() and vertex(). The view refers to the vertices
+// of the graph it was built from, so it must not outlive it or be used after the graph
+// is modified. That includes digraph::reserve(), shrink_to_fit() and max_load_factor(),
+// which may rehash the vertex set and invalidate the iterators held by the view.
+template<typename DiGraphT>
+class csr_view;
+
+template<typename edge_t, class vertex_getter, class... T>
+class csr_view<digraph<edge_t, vertex_getter, T...>>
+{
+public:
+    using graph_type = digraph<edge_t, vertex_getter, T...>;
+    using vertex_type = typename graph_type::vertex_type;
+    using underlying_vertex_type = typename graph_type::underlying_vertex_type;
+    using vertex_const_iterator = typename graph_type::vertex_const_iterator;
+    using index_container = std::vector<size_t>;
+
+    explicit csr_view( const graph_type& g );
+
+    size_t num_vertices() const noexcept;
+    size_t num_edges() const noexcept;
+
+    vertex_const_iterator vertex( size_t id ) const;
+    // returns num_vertices() if the vertex is not part of the graph
+    size_t id( const underlying_vertex_type& _vertex ) const;
+
+    // out_targets()[out_offsets()[v]..out_offsets()[v+1]) are the successors of v
+    const index_container& out_offsets() const noexcept;
+    const index_container& out_targets() const noexcept;
+    // in_sources()[in_offsets()[v]..in_offsets()[v+1]) are the predecessors of v
+    const index_container& in_offsets() const noexcept;
+    const index_container& in_sources() const noexcept;
+
+private:
+    using id_map_t = std::unordered_map<vertex_type, size_t, typename graph_type::vertex_hash, typename graph_type::vertex_equal_to>;
+    using dense_storage_t = typename graph_type::dense_vertex_storage;
+
+    bool number_by_index( const graph_type& g, std::true_type );
+    bool number_by_index( const graph_type&, std::false_type ) noexcept { return false; }
+    size_t index_id( const underlying_vertex_type& _vertex, std::true_type ) const;
+    size_t index_id( const underlying_vertex_type&, std::false_type ) const noexcept { return num_vertices(); }
+
+    bool                                _by_index = false;
+    std::vector<vertex_const_iterator>  _vertices;
+    id_map_t                            _ids;
+    index_container                     _out_offsets;
+    index_container                     _out_targets;
+    index_container                     _in_offsets;
+    index_container                     _in_sources;
+};
+
+template<typename DiGraphT>
+inline csr_view<DiGraphT> make_csr_view( const DiGraphT& g )
+{
+    return csr_view<DiGraphT>( g );
+}
+
+struct pagerank_options
+{
+    double damping = 0.85;
+    double tolerance = 1e-9;        // stop once the L1 norm of the change drops below this
+    size_t max_iterations = 100;
+    size_t threads = 0;             // 0 selects the thread count automatically, never more than the vertices
+};
+
+struct pagerank_result
+{
+    std::vector<double> rank;
+    size_t iterations;
+    double residual;
+    size_t threads;                 // number of workers that took part in the solve
+};
+
+template<typename DiGraphT>
+pagerank_result pagerank( const csr_view<DiGraphT>& g, const pagerank_options& options = pagerank_options() );
+
+template<typename DiGraphT>
+std::vector<double> in_degree_centrality( const csr_view<DiGraphT>& g, size_t threads = 0 );
+
+template<typename DiGraphT>
+std::vector<double> out_degree_centrality( const csr_view<DiGraphT>& g, size_t threads = 0 );
+
+struct components_result
+{
+    std::vector<size_t> component;  // component id of every vertex, ids are 0..sizes.size()-1
+    std::vector<size_t> sizes;      // number of vertices in each component
+    size_t threads;                 // number of workers that processed edges
+};
+
+// The union-find runs on dense vertex ids, which is why this takes a csr_view rather
+// than the digraph itself. Callers that only need components still pay for building
+// the view, including both its out- and in-adjacency.
+template<typename DiGraphT>
+components_result weakly_connected_components( const csr_view<DiGraphT>& g, size_t threads = 0 );
+
+///////////////////////
+///////////////////////
+///////////////////////
+
+namespace detail
+{
+
+inline void build_csr_rows( const std::vector<std::pair<size_t, size_t>>& arcs, size_t vertex_count,
+    std::vector<size_t>& offsets, std::vector<size_t>& targets )
+{
+    offsets.assign( vertex_count + 1, 0 );
+    for (const auto& a : arcs) ++offsets[a.first + 1];
+    std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+    targets.resize( arcs.size() );
+    std::vector<size_t> cursor( offsets.begin(), offsets.end() - 1 );
+    for (const auto& a : arcs) targets[cursor[a.first]++] = a.second;
+    // ascending neighbours keep the gathers of the pull loops as sequential as possible
+    for (size_t v = 0; v < vertex_count; ++v) {
+        std::sort( targets.begin() + offsets[v], targets.begin() + offsets[v + 1] );
+    }
+}
+
+// lock-free disjoint set forest, roots are always linked below the smaller root
+// so concurrent unions can never create a cycle
+class concurrent_union_find
+{
+public:
+    explicit concurrent_union_find( size_t size ) : _parent( size )
+    {
+        for (size_t i = 0; i < size; ++i) _parent[i].store( i, std::memory_order_relaxed );
+    }
+
+    // path halving, a failed exchange only means another thread already shortened the path
+    size_t find( size_t x ) noexcept
+    {
+        size_t p = _parent[x].load( std::memory_order_acquire );
+        while (p != x) {
+            size_t gp = _parent[p].load( std::memory_order_acquire );
+            if (gp != p) {
+                _parent[x].compare_exchange_weak( p, gp, std::memory_order_acq_rel, std::memory_order_acquire );
+            }
+            x = p;
+            p = _parent[x].load( std::memory_order_acquire );
+        }
+        return x;
+    }
+
+    void unite( size_t a, size_t b ) noexcept
+    {
+        for (;;) {
+            a = find( a );
+            b = find( b );
+            if (a == b) return;
+            if (a < b) std::swap( a, b );
+            size_t expected = a;
+            if (_parent[a].compare_exchange_strong( expected, b, std::memory_order_acq_rel, std::memory_order_acquire )) return;
+        }
+    }
+
+private:
+    std::vector<std::atomic<size_t>> _parent;
+};
+
+inline std::vector<double> degree_centrality( const std::vector<size_t>& offsets, size_t threads )
+{
+    const size_t n = offsets.empty() ? 0 : offsets.size() - 1;
+    std::vector<double> result( n, 0.0 );
+    if (n < 2) return result;
+    const double scale = 1.0 / static_cast<double>(n - 1);
+    parallel_for( n, thread_count( threads, n ), [&]( size_t begin, size_t end, size_t ) {
+        for (size_t v = begin; v < end; ++v) {
+            result[v] = static_cast<double>(offsets[v + 1] - offsets[v]) * scale;
+        }
+    } );
+    return result;
+}
+
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline csr_view<digraph<edge_t, vertex_getter, T...>>::csr_view( const graph_type& g )
+{
+    _by_index = number_by_index( g, dense_storage_t() );
+    if (!_by_index) {
+        _vertices.reserve( g.vertices().size() );
+        _ids.reserve( g.vertices().size() );
+        for (auto it = g.vertices().begin(); it != g.vertices().end(); ++it) {
+            _ids.emplace( *it, _vertices.size() );
+            _vertices.push_back( it );
+        }
+    }
+
+    std::vector<std::pair<size_t, size_t>> arcs;
+    arcs.reserve( g.edges().size() );
+    for (const auto& e : g.edges()) {
+        const auto curr_vertices = vertex_getter()(e);
+        const auto from = id( detail::derefence( curr_vertices.first ) );
+        const auto to = id( detail::derefence( curr_vertices.second ) );
+        assert( from < num_vertices() && to < num_vertices() );
+        arcs.emplace_back( from, to );
+    }
+    detail::build_csr_rows( arcs, num_vertices(), _out_offsets, _out_targets );
+    for (auto& a : arcs) std::swap( a.first, a.second );
+    detail::build_csr_rows( arcs, num_vertices(), _in_offsets, _in_sources );
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline bool csr_view<digraph<edge_t, vertex_getter, T...>>::number_by_index( const graph_type& g, std::true_type )
+{
+    using dense_traits = detail::dense_traits_t<edge_t, vertex_getter>;
+    const size_t n = g.vertices().size();
+    std::vector<vertex_const_iterator> vertices( n );
+    std::vector<bool> seen( n, false );
+    for (auto it = g.vertices().begin(); it != g.vertices().end(); ++it) {
+        const auto index = dense_traits::index( detail::derefence( *it ) );
+        if (index >= n || seen[index])return false;
+        seen[index] = true;
+        vertices[index] = it;
+    }
+    _vertices.swap( vertices );
+    return true;
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline size_t csr_view<digraph<edge_t, vertex_getter, T...>>::index_id( const underlying_vertex_type& _vertex, std::true_type ) const
+{
+    const auto index = detail::dense_traits_t<edge_t, vertex_getter>::index( _vertex );
+    return index < num_vertices() ? index : num_vertices();
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline size_t csr_view<digraph<edge_t, vertex_getter, T...>>::num_vertices() const noexcept
+{
+    return _vertices.size();
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline size_t csr_view<digraph<edge_t, vertex_getter, T...>>::num_edges() const noexcept
+{
+    return _out_targets.size();
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline auto csr_view<digraph<edge_t, vertex_getter, T...>>::vertex( size_t _id ) const -> vertex_const_iterator
+{
+    assert( _id < num_vertices() );
+    return _vertices[_id];
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline size_t csr_view<digraph<edge_t, vertex_getter, T...>>::id( const underlying_vertex_type& _vertex ) const
+{
+    if (_by_index)return index_id( _vertex, dense_storage_t() );
+    const auto it = _ids.find( vertex_type( _vertex ) );
+    return it == _ids.end() ? num_vertices() : it->second;
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline auto csr_view<digraph<edge_t, vertex_getter, T...>>::out_offsets() const noexcept -> const index_container&
+{
+    return _out_offsets;
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline auto csr_view<digraph<edge_t, vertex_getter, T...>>::out_targets() const noexcept -> const index_container&
+{
+    return _out_targets;
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline auto csr_view<digraph<edge_t, vertex_getter, T...>>::in_offsets() const noexcept -> const index_container&
+{
+    return _in_offsets;
+}
+
+template<typename edge_t, class vertex_getter, class... T>
+inline auto csr_view<digraph<edge_t, vertex_getter, T...>>::in_sources() const noexcept -> const index_container&
+{
+    return _in_sources;
+}
+
+template<typename DiGraphT>
+inline pagerank_result pagerank( const csr_view<DiGraphT>& g, const pagerank_options& options )
+{
+    const size_t n = g.num_vertices();
+    pagerank_result result{ std::vector<double>( n, n ? 1.0 / static_cast<double>(n) : 0.0 ), 0, 0.0, 0 };
+    if (n == 0) return result;
+
+    const size_t threads = detail::thread_count( options.threads, n );
+    const double d = options.damping;
+    const size_t* out_offsets = g.out_offsets().data();
+    const size_t* in_offsets = g.in_offsets().data();
+    const size_t* in_sources = g.in_sources().data();
+    std::vector<double> contribution( n ), scratch( n ), dangling_partial( threads ), delta_partial( threads );
+    double* const contrib = contribution.data();
+    const double* final_rank = result.rank.data();
+    detail::barrier sync( threads );
+    std::atomic<size_t> workers( 0 );
+
+    // the workers are started once and keep their chunk for the whole solve, the phases are
+    // separated by barriers; every thread reduces the partial sums itself in the same order,
+    // so all of them agree on the convergence test without further communication
+    detail::parallel_for( n, threads, [&]( size_t begin, size_t end, size_t chunk ) {
+        workers.fetch_add( 1, std::memory_order_relaxed );
+        double* rank = result.rank.data();
+        double* next = scratch.data();
+        size_t iterations = 0;
+        double residual = 0.0;
+        while (iterations < options.max_iterations) {
+            // push phase is local: every vertex publishes rank / out_degree, dangling mass is collected
+            double dangling = 0.0;
+            for (size_t v = begin; v < end; ++v) {
+                const size_t degree = out_offsets[v + 1] - out_offsets[v];
+                contrib[v] = degree ? rank[v] / static_cast<double>(degree) : 0.0;
+                dangling += degree ? 0.0 : rank[v];
+            }
+            dangling_partial[chunk] = dangling;
+            sync.arrive_and_wait();
+
+            dangling = std::accumulate( dangling_partial.begin(), dangling_partial.end(), 0.0 );
+            const double base = ((1.0 - d) + d * dangling) / static_cast<double>(n);
+
+            // pull phase: each vertex only writes its own slot
+            double delta = 0.0;
+            for (size_t v = begin; v < end; ++v) {
+                double sum = 0.0;
+                for (size_t k = in_offsets[v]; k < in_offsets[v + 1]; ++k) sum += contrib[in_sources[k]];
+                next[v] = base + d * sum;
+                delta += std::fabs( next[v] - rank[v] );
+            }
+            delta_partial[chunk] = delta;
+            sync.arrive_and_wait();
+
+            residual = std::accumulate( delta_partial.begin(), delta_partial.end(), 0.0 );
+            std::swap( rank, next );
+            ++iterations;
+            if (residual < options.tolerance) break;
+        }
+        if (chunk == 0) {
+            result.iterations = iterations;
+            result.residual = residual;
+            final_rank = rank;
+        }
+    } );
+
+    if (final_rank != result.rank.data()) result.rank.swap( scratch );
+    result.threads = workers.load( std::memory_order_relaxed );
+    return result;
+}
+
+template<typename DiGraphT>
+inline std::vector<double> in_degree_centrality( const csr_view<DiGraphT>& g, size_t threads )
+{
+    return detail::degree_centrality( g.in_offsets(), threads );
+}
+
+template<typename DiGraphT>
+inline std::vector<double> out_degree_centrality( const csr_view<DiGraphT>& g, size_t threads )
+{
+    return detail::degree_centrality( g.out_offsets(), threads );
+}
+
+template<typename DiGraphT>
+inline components_result weakly_connected_components( const csr_view<DiGraphT>& g, size_t threads )
+{
+    const size_t n = g.num_vertices();
+    const size_t m = g.num_edges();
+    const auto& offsets = g.out_offsets();
+    const auto& targets = g.out_targets();
+    detail::concurrent_union_find sets( n );
+    std::atomic<size_t> workers( 0 );
+
+    // chunks are cut on the edge array so that high degree vertices don't serialize the work
+    detail::parallel_for( m, detail::thread_count( threads, m ), [&]( size_t begin, size_t end, size_t ) {
+        if (begin == end) return;
+        workers.fetch_add( 1, std::memory_order_relaxed );
+        size_t v = static_cast<size_t>(std::upper_bound( offsets.begin(), offsets.end(), begin ) - offsets.begin()) - 1;
+        for (size_t k = begin; k < end; ++k) {
+            while (offsets[v + 1] <= k) ++v;
+            sets.unite( v, targets[k] );
+        }
+    } );
+
+    components_result result{ std::vector<size_t>( n ), {}, workers.load( std::memory_order_relaxed ) };
+    detail::parallel_for( n, detail::thread_count( threads, n ), [&]( size_t begin, size_t end, size_t ) {
+        for (size_t v = begin; v < end; ++v) result.component[v] = sets.find( v );
+    } );
+
+    // every root is the smallest vertex of its component, so it is labeled before its members
+    for (size_t v = 0; v < n; ++v) {
+        const size_t root = result.component[v];
+        if (root == v) {
+            result.component[v] = result.sizes.size();
+            result.sizes.push_back( 0 );
+        } else {
+            result.component[v] = result.component[root];
+        }
+        ++result.sizes[result.component[v]];
+    }
+    return result;
+}
+
+}  //namespace digraph
+
+#endif  //DIGRAPH_ANALYTICS_H_INCLUDED__
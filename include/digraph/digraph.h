@@ -11,6 +11,7 @@
 #include <iterator>
 #include <cassert>
 #include <initializer_list>
+#include <stdexcept>
 
 namespace digraph
 {
@@ -139,6 +140,62 @@ using hash_t = typename unordered_traits < T, Hash, std::equal_to<size_t> > ::ha
 template<typename T,typename EqualTo>
 using equal_to_t = typename unordered_traits < T, std::hash<size_t>, EqualTo>::equal_to;
 
+// base of the dense_vertex_traits the library provides itself, as opposed to user specializations
+struct builtin_dense_traits {};
+
+template<typename EqualTo, typename T>
+struct is_std_equal_to : std::false_type {};
+
+template<typename U, typename T>
+struct is_std_equal_to<std::equal_to<U>, T> : std::is_same<std::remove_cv_t<U>, std::remove_cv_t<T>> {};
+
+template<typename T>
+struct is_std_equal_to<std::equal_to<void>, T> : std::true_type {};
+
+}
+
+
+// Vertex types for which dense_vertex_traits<T>::is_dense is std::true_type are stored
+// in direct-indexed arrays instead of hash tables. Integral types are dense by default
+// as long as the graph compares vertices with std::equal_to, other types can opt in by
+// specializing this template and providing a static size_t index( const T& ) mapping
+// each vertex to a small non-negative id, equal vertices must map to the same id.
+// Graphs whose ids turn out to be negative or too sparse for direct indexing are
+// kept in the hashed representation instead.
+template<typename T, typename = void>
+struct dense_vertex_traits
+{
+    using is_dense = std::false_type;
+};
+
+template<typename T>
+struct dense_vertex_traits<T, std::enable_if_t<std::is_integral<T>::value>> : detail::builtin_dense_traits
+{
+    using is_dense = std::true_type;
+
+    // negative ids wrap around to huge indices, which are never directly indexed
+    static size_t index( T t ) noexcept
+    {
+        return static_cast<size_t>(t);
+    }
+};
+
+namespace detail
+{
+
+template<typename edge_t, class vertex_getter >
+using dense_traits_t = dense_vertex_traits<std::remove_cv_t<underlying_type_t<edge_t, vertex_getter>>>;
+
+template<typename edge_t, class vertex_getter >
+using is_dense_vertex_t = typename dense_traits_t<edge_t, vertex_getter>::is_dense;
+
+// the builtin index only agrees with the vertex equality if that is the standard one,
+// a user specialization is trusted to match whatever equality the graph uses
+template<typename edge_t, class vertex_getter, class vertex_equal_to >
+using use_dense_repr_t = std::integral_constant<bool, is_dense_vertex_t<edge_t, vertex_getter>::value &&
+    (!std::is_base_of<builtin_dense_traits, dense_traits_t<edge_t, vertex_getter>>::value ||
+        is_std_equal_to<vertex_equal_to, underlying_type_t<edge_t, vertex_getter>>::value)>;
+
 }
 
 
@@ -163,6 +220,8 @@ public:
     using vertex_const_iterator = typename vertex_container::const_iterator;
     using edge_iterator = typename edge_container::iterator;
     using edge_const_iterator = typename edge_container::const_iterator;
+    // std::true_type if the adjacency is indexed by dense_vertex_traits<>::index
+    using dense_vertex_storage = detail::use_dense_repr_t<edge_t, vertex_getter, vertex_equal_to_>;
 
 
     digraph() = default;
@@ -191,7 +250,25 @@ public:
     bool operator==( const digraph& ) const noexcept;
     bool operator!=( const digraph& ) const noexcept;
 
+    // pre-sizes the edge and vertex sets and the outer adjacency table, expected_out_degree
+    // sizes the per vertex adjacency and is kept as a hint when it is rebuilt; for dense vertex
+    // types the adjacency is indexed by vertex id, so only the per vertex lists are reserved
+    void reserve( size_t edge_count, size_t vertex_count, size_t expected_out_degree = 0 );
+    // releases unused capacity of every table and drops the out degree hint
+    void shrink_to_fit();
+    float max_load_factor() const noexcept;
+    // applied to the edge and vertex sets and to the adjacency hash tables alike,
+    // throws std::invalid_argument unless ml is positive
+    void max_load_factor( float ml );
+    // all three rebuild the adjacency in O(E) whenever the edge or vertex set gets rehashed
+
 private:
+    struct capacity_policy
+    {
+        float   max_load_factor = 1.0f;
+        size_t  expected_out_degree = 0;
+    };
+
     struct hash_vertex_iterator
     {
         using has_ret_type = decltype(std::declval<vertex_hash>()(std::declval<underlying_vertex_type>()));
@@ -211,22 +288,77 @@ private:
     };
 
     using graph_val_t = std::unordered_map<vertex_const_iterator, edge_const_iterator, hash_vertex_iterator, equal_to_vertex_iterator>;
-    using graph_repr_t = std::unordered_map<vertex_const_iterator, graph_val_t, hash_vertex_iterator, equal_to_vertex_iterator>;
-    using graph_val_iterator = typename graph_val_t::iterator;
-    using graph_val_const_iterator = typename graph_val_t::const_iterator;
-    using graph_repr_iterator = typename graph_repr_t::iterator;
-    using graph_repr_const_iterator = typename graph_repr_t::const_iterator;
+    using graph_map_t = std::unordered_map<vertex_const_iterator, graph_val_t, hash_vertex_iterator, equal_to_vertex_iterator>;
+
+    // adjacency keyed by vertex iterators, used for arbitrary vertex types
+    struct hashed_graph_repr
+    {
+        hashed_graph_repr() = default;
+        hashed_graph_repr( const edge_container&, const vertex_container&, const capacity_policy& );
+
+        vertex_const_iterator find( const underlying_vertex_type&, const vertex_container& ) const;
+        edge_const_iterator find( const underlying_vertex_type&, const underlying_vertex_type&,
+            const edge_container&, const vertex_container& ) const;
+        bool equal( const hashed_graph_repr& rhs, const vertex_container& rhs_vertices ) const noexcept;
+
+        void reserve( size_t vertex_count, size_t expected_out_degree );
+        void shrink_to_fit();
+        void max_load_factor( float ml );
+
+        graph_map_t g;
+    };
+
+    // adjacency indexed directly by dense_vertex_traits<>::index, no hashing involved
+    // as long as the ids are compact enough, otherwise everything is delegated to fallback
+    struct dense_graph_repr
+    {
+        using dense_traits = detail::dense_traits_t<edge_t, vertex_getter>;
+        using adjacent_t = std::pair<size_t, edge_const_iterator>;
+
+        struct slot
+        {
+            bool                    present = false;
+            vertex_const_iterator   vertex;
+            std::vector<adjacent_t> out;  // sorted by target index
+        };
+
+        dense_graph_repr() = default;
+        dense_graph_repr( const edge_container&, const vertex_container&, const capacity_policy& );
+
+        vertex_const_iterator find( const underlying_vertex_type&, const vertex_container& ) const;
+        edge_const_iterator find( const underlying_vertex_type&, const underlying_vertex_type&,
+            const edge_container&, const vertex_container& ) const;
+        bool equal( const dense_graph_repr& rhs, const vertex_container& rhs_vertices ) const noexcept;
+
+        void reserve( size_t vertex_count, size_t expected_out_degree );
+        void shrink_to_fit();
+        void max_load_factor( float ml );
+
+        // largest index still stored directly for a graph of vertex_count vertices
+        static size_t max_index( size_t vertex_count ) noexcept
+        {
+            return 4 * vertex_count + 64;
+        }
+
+        bool                dense = true;
+        std::vector<slot>   slots;
+        hashed_graph_repr   fallback;
+    };
+
+    using graph_repr_t = std::conditional_t<dense_vertex_storage::value, dense_graph_repr, hashed_graph_repr>;
 
-    static graph_repr_t build_graph( const edge_container&, const vertex_container& );
+    static graph_repr_t build_graph( const edge_container&, const vertex_container&, const capacity_policy& );
     static vertex_const_iterator map_vertex( vertex_const_iterator from, const vertex_container& to );
-    static graph_repr_const_iterator map_vertex( vertex_const_iterator from, const digraph& to );
 
     void rebuild_graph();
+    template<typename F>
+    void rehash_sets( F f );
     graph_repr_t& graph() noexcept;
     const graph_repr_t& graph() const noexcept;
 
     edge_container      _edges;
     vertex_container    _vertices;
+    capacity_policy     _policy;
     graph_repr_t        _g;
 };
 
@@ -271,13 +403,13 @@ inline digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, ver
 
 template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
 inline digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::digraph( const digraph & other ) :
-    _vertices( other._vertices ), _edges( other._edges ), _g( build_graph( _edges , _vertices ) )
+    _vertices( other._vertices ), _edges( other._edges ), _policy( other._policy ), _g( build_graph( _edges , _vertices, _policy ) )
 {
 }
 
 template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
 inline digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::digraph( digraph && other ) noexcept :
-    _vertices( std::move( other._vertices ) ), _edges( std::move( other._edges ) ), _g( std::move( other._g ) )
+    _vertices( std::move( other._vertices ) ), _edges( std::move( other._edges ) ), _policy( other._policy ), _g( std::move( other._g ) )
 {}
 
 template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
@@ -286,10 +418,11 @@ inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash
     using std::swap;
     auto vertices = other._vertices;
     auto edges = other._edges;
-    auto g = build_graph( edges, vertices );
+    auto g = build_graph( edges, vertices, other._policy );
     swap( _edges, edges );
     swap( _vertices, vertices );
     swap( _g, g );
+    _policy = other._policy;
     return *this;
 }
 
@@ -300,6 +433,7 @@ inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash
     if (this != &other) {
         _edges = std::move( other._edges );
         _vertices = std::move( other._vertices );
+        _policy = other._policy;
         _g = std::move( other._g );
     }
     return *this;
@@ -311,6 +445,7 @@ inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash
     using std::swap;
     swap( _edges, other._edges );
     swap( _vertices, other._vertices );
+    swap( _policy, other._policy );
     swap( _g, other._g );
 }
 
@@ -354,46 +489,279 @@ template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal
 inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash_, vertex_equal_to_>::
 find( const underlying_vertex_type & _from, const underlying_vertex_type & _to ) const -> edge_const_iterator
 {
-    const auto from = _vertices.find( vertex_type( _from ) );
-    if (from == _vertices.end())return _edges.end();
-    const auto to = _vertices.find( vertex_type( _to ) );
-    if(to == _vertices.end())return _edges.end();
-    const auto g_from = _g.find( from );
-    if (g_from == _g.end())return _edges.end();
-    const auto g_to = g_from->second.find( to );
-    if (g_to == g_from->second.end())return _edges.end();
-    return g_to->second;
+    return _g.find( _from, _to, _edges, _vertices );
 }
 
 template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
 inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::find( const underlying_vertex_type& _vertex ) const -> vertex_const_iterator
 {
-    return _vertices.find( vertex_type( _vertex ) );
+    return _g.find( _vertex, _vertices );
 }
 
 template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
 inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::
-build_graph( const edge_container& edges, const vertex_container& vertices ) -> graph_repr_t
+build_graph( const edge_container& edges, const vertex_container& vertices, const capacity_policy& policy ) -> graph_repr_t
+{
+    return graph_repr_t( edges, vertices, policy );
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+template<typename F>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::rehash_sets( F f )
+{
+    const auto edge_buckets = _edges.bucket_count();
+    const auto vertex_buckets = _vertices.bucket_count();
+    f();
+    // rehashing invalidates the iterators stored in the adjacency
+    if (edge_buckets != _edges.bucket_count() || vertex_buckets != _vertices.bucket_count())rebuild_graph();
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::
+reserve( size_t edge_count, size_t vertex_count, size_t expected_out_degree )
 {
-    graph_repr_t g;
+    _policy.expected_out_degree = expected_out_degree;
+    rehash_sets( [&]() {
+        _edges.reserve( edge_count );
+        _vertices.reserve( vertex_count );
+    } );
+    _g.reserve( vertex_count, expected_out_degree );
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::shrink_to_fit()
+{
+    _policy.expected_out_degree = 0;
+    rehash_sets( [&]() {
+        _edges.rehash( 0 );
+        _vertices.rehash( 0 );
+    } );
+    _g.shrink_to_fit();
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline float digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::max_load_factor() const noexcept
+{
+    return _policy.max_load_factor;
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::max_load_factor( float ml )
+{
+    if (!(ml > 0.0f))throw std::invalid_argument( "digraph::max_load_factor must be positive" );
+    _policy.max_load_factor = ml;
+    rehash_sets( [&]() {
+        _edges.max_load_factor( ml );
+        _vertices.max_load_factor( ml );
+    } );
+    _g.max_load_factor( ml );
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::hashed_graph_repr::
+hashed_graph_repr( const edge_container& edges, const vertex_container& vertices, const capacity_policy& policy )
+{
+    g.max_load_factor( policy.max_load_factor );
+    g.reserve( vertices.size() );
     for (auto edge_it = edges.begin(); edge_it != edges.end(); ++edge_it) {
         const auto curr_vertices = vertex_getter()(*edge_it);
-        auto begin = std::find_if( vertices.begin(), vertices.end(),
-            [&]( const auto& n ) { return vertex_equal_to()(n, curr_vertices.first); } );
+        auto begin = vertices.find( curr_vertices.first );
         assert( begin != vertices.end() );
-        auto i = g.emplace( begin, graph_val_t{} );
-        auto end = std::find_if( vertices.begin(), vertices.end(),
-            [&]( const auto& n ) { return vertex_equal_to()(n, curr_vertices.second); } );
+        auto i = g.find( begin );
+        if (i == g.end()) {
+            graph_val_t val;
+            val.max_load_factor( policy.max_load_factor );
+            val.reserve( policy.expected_out_degree );
+            i = g.emplace( begin, std::move( val ) ).first;
+        }
+        auto end = vertices.find( curr_vertices.second );
         assert( end != vertices.end() );
-        i.first->second.emplace( end, edge_it );
+        i->second.emplace( end, edge_it );
     }
-    return g;
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline bool digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::hashed_graph_repr::
+equal( const hashed_graph_repr& rhs, const vertex_container& rhs_vertices ) const noexcept
+{
+    if (g.size() != rhs.g.size())return false;
+    for(auto from_it = g.begin(); from_it != g.end();++from_it){
+        auto rhs_from = map_vertex( from_it->first, rhs_vertices );
+        if (rhs_from == rhs_vertices.end())return false;
+        auto rhs_from_it = rhs.g.find( rhs_from );
+        if(rhs_from_it == rhs.g.end() || from_it->second.size() != rhs_from_it->second.size())return false;
+        for (auto to_it = from_it->second.begin(); to_it != from_it->second.end(); ++to_it) {
+            auto rhs_to = map_vertex( to_it->first, rhs_vertices );
+            if (rhs_to == rhs_vertices.end())return false;
+            auto rhs_to_it = rhs_from_it->second.find( rhs_to );
+            if (rhs_to_it == rhs_from_it->second.end() ||
+                !edge_equal_to()(*to_it->second, *rhs_to_it->second) )return false;
+        }
+    }
+    return true;
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::hashed_graph_repr::
+reserve( size_t vertex_count, size_t expected_out_degree )
+{
+    g.reserve( vertex_count );
+    for (auto& adjacent : g) adjacent.second.reserve( expected_out_degree );
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::hashed_graph_repr::shrink_to_fit()
+{
+    g.rehash( 0 );
+    for (auto& adjacent : g) adjacent.second.rehash( 0 );
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::hashed_graph_repr::max_load_factor( float ml )
+{
+    g.max_load_factor( ml );
+    for (auto& adjacent : g) adjacent.second.max_load_factor( ml );
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::hashed_graph_repr::
+find( const underlying_vertex_type& _vertex, const vertex_container& vertices ) const -> vertex_const_iterator
+{
+    return vertices.find( vertex_type( _vertex ) );
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::hashed_graph_repr::
+find( const underlying_vertex_type& _from, const underlying_vertex_type& _to,
+    const edge_container& edges, const vertex_container& vertices ) const -> edge_const_iterator
+{
+    const auto from = vertices.find( vertex_type( _from ) );
+    if (from == vertices.end())return edges.end();
+    const auto to = vertices.find( vertex_type( _to ) );
+    if(to == vertices.end())return edges.end();
+    const auto g_from = g.find( from );
+    if (g_from == g.end())return edges.end();
+    const auto g_to = g_from->second.find( to );
+    if (g_to == g_from->second.end())return edges.end();
+    return g_to->second;
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::dense_graph_repr::
+dense_graph_repr( const edge_container& edges, const vertex_container& vertices, const capacity_policy& policy )
+{
+    size_t size = 0;
+    for (const auto& v : vertices) {
+        const auto index = dense_traits::index( detail::derefence( v ) );
+        if (index > max_index( vertices.size() )) {
+            dense = false;
+            fallback = hashed_graph_repr( edges, vertices, policy );
+            return;
+        }
+        size = std::max( size, index + 1 );
+    }
+    slots.resize( size );
+    for (auto vertex_it = vertices.begin(); vertex_it != vertices.end(); ++vertex_it) {
+        const auto index = dense_traits::index( detail::derefence( *vertex_it ) );
+        slots[index].present = true;
+        slots[index].vertex = vertex_it;
+        slots[index].out.reserve( policy.expected_out_degree );
+    }
+    for (auto edge_it = edges.begin(); edge_it != edges.end(); ++edge_it) {
+        const auto curr_vertices = vertex_getter()(*edge_it);
+        const auto from = dense_traits::index( detail::derefence( curr_vertices.first ) );
+        const auto to = dense_traits::index( detail::derefence( curr_vertices.second ) );
+        assert( from < slots.size() && slots[from].present );
+        assert( to < slots.size() && slots[to].present );
+        slots[from].out.emplace_back( to, edge_it );
+    }
+    const auto less = []( const adjacent_t& lhs, const adjacent_t& rhs ) { return lhs.first < rhs.first; };
+    const auto same = []( const adjacent_t& lhs, const adjacent_t& rhs ) { return lhs.first == rhs.first; };
+    for (auto& s : slots) {
+        // keep the first edge per target, just like emplace into the hashed representation does
+        std::stable_sort( s.out.begin(), s.out.end(), less );
+        s.out.erase( std::unique( s.out.begin(), s.out.end(), same ), s.out.end() );
+    }
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline bool digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::dense_graph_repr::
+equal( const dense_graph_repr& rhs, const vertex_container& rhs_vertices ) const noexcept
+{
+    if (dense != rhs.dense)return false;
+    if (!dense)return fallback.equal( rhs.fallback, rhs_vertices );
+    if (slots.size() != rhs.slots.size())return false;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const auto& lhs_slot = slots[i];
+        const auto& rhs_slot = rhs.slots[i];
+        if (lhs_slot.present != rhs_slot.present || lhs_slot.out.size() != rhs_slot.out.size())return false;
+        for (size_t k = 0; k < lhs_slot.out.size(); ++k) {
+            if (lhs_slot.out[k].first != rhs_slot.out[k].first ||
+                !edge_equal_to()(*lhs_slot.out[k].second, *rhs_slot.out[k].second) )return false;
+        }
+    }
+    return true;
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::dense_graph_repr::
+reserve( size_t vertex_count, size_t expected_out_degree )
+{
+    if (!dense) {
+        fallback.reserve( vertex_count, expected_out_degree );
+        return;
+    }
+    // slots are indexed by vertex id and sized to the id range on build, vertex_count says nothing about it
+    for (auto& s : slots) s.out.reserve( expected_out_degree );
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::dense_graph_repr::shrink_to_fit()
+{
+    if (!dense) {
+        fallback.shrink_to_fit();
+        return;
+    }
+    slots.shrink_to_fit();
+    for (auto& s : slots) s.out.shrink_to_fit();
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::dense_graph_repr::max_load_factor( float ml )
+{
+    fallback.max_load_factor( ml );
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::dense_graph_repr::
+find( const underlying_vertex_type& _vertex, const vertex_container& vertices ) const -> vertex_const_iterator
+{
+    if (!dense)return fallback.find( _vertex, vertices );
+    const auto index = dense_traits::index( _vertex );
+    if (index >= slots.size() || !slots[index].present)return vertices.end();
+    return slots[index].vertex;
+}
+
+template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
+inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::dense_graph_repr::
+find( const underlying_vertex_type& _from, const underlying_vertex_type& _to,
+    const edge_container& edges, const vertex_container& vertices ) const -> edge_const_iterator
+{
+    if (!dense)return fallback.find( _from, _to, edges, vertices );
+    const auto from = dense_traits::index( _from );
+    if (from >= slots.size() || !slots[from].present)return edges.end();
+    const auto to = dense_traits::index( _to );
+    const auto& out = slots[from].out;
+    const auto g_to = std::lower_bound( out.begin(), out.end(), to,
+        []( const adjacent_t& a, size_t index ) { return a.first < index; } );
+    if (g_to == out.end() || g_to->first != to)return edges.end();
+    return g_to->second;
 }
 
 template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
 inline void digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::rebuild_graph()
 {
-    _g = build_graph( _edges, _vertices );
+    _g = build_graph( _edges, _vertices, _policy );
 }
 
 template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
@@ -401,12 +769,13 @@ template<typename InputIterator>
 inline digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::digraph( InputIterator begin, InputIterator end ) :
     _edges( detail::to_unique_set<edge_t, edge_hash, edge_equal_to>( begin, end ) )
 {
+    // sized for the common case of not having more vertices than edges
+    _vertices.reserve( _edges.size() );
     std::for_each( _edges.begin(), _edges.end(), [this]( const auto& e ) {
         const auto vertices = vertex_getter()(e);
         _vertices.emplace( vertices.first );
         _vertices.emplace( vertices.second );
     } );
-    _vertices = detail::to_unique_set<vertex_type, vertex_hash, vertex_equal_to>( _vertices.begin(), _vertices.end() );
     rebuild_graph();
 }
 
@@ -416,14 +785,6 @@ inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash
     return to.find( *from );
 }
 
-template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
-inline auto digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::map_vertex( vertex_const_iterator from, const digraph& to ) -> graph_repr_const_iterator
-{
-    auto to_it = map_vertex( from, to.vertices() );
-    if (to_it == to.vertices().end())return to.graph().end();
-    return to.graph().find( to_it );
-}
-
 template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
 inline bool digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash, vertex_equal_to>::operator==( const digraph& rhs) const noexcept
 {
@@ -440,16 +801,7 @@ inline bool digraph<edge_t, vertex_getter, edge_hash, edge_equal_to, vertex_hash
             !vertex_equal_to()(detail::derefence( *v_it ), detail::derefence( *rhs_v_it )) )return false;
     }
 
-    for(auto from_it = lhs.graph().begin(); from_it != lhs.graph().end();++from_it){
-        auto rhs_from_it = map_vertex( from_it->first, rhs );
-        if(rhs_from_it == rhs.graph().end() || from_it->second.size() != rhs_from_it->second.size())return false;
-        for (auto to_it = from_it->second.begin(); to_it != from_it->second.end(); ++to_it) {
-            auto rhs_to_it = rhs_from_it->second.find( map_vertex( to_it->first, rhs.vertices() ) );
-            if (rhs_to_it == rhs_from_it->second.end() ||
-                !edge_equal_to()(*to_it->second, *rhs_to_it->second) )return false;
-        }
-    }
-    return true;
+    return lhs.graph().equal( rhs.graph(), rhs.vertices() );
 }
 
 template<typename edge_t, class vertex_getter, class edge_hash, class edge_equal_to, class vertex_hash, class vertex_equal_to>
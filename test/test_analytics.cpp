@@ -0,0 +1,251 @@
+#include <string>
+#include <numeric>
+
+#include "catch.hpp"
+
+#include <digraph/analytics.h>
+
+
+namespace
+{
+
+struct Edge
+{
+    std::string from;
+    std::string to;
+};
+
+struct hash_Edge
+{
+    size_t operator()( const Edge& t )const noexcept
+    {
+        return std::hash<std::string>()(t.from) ^ (std::hash<std::string>()(t.to) << 1);
+    }
+};
+
+struct equal_to_Edge
+{
+    bool operator()( const Edge& lhs, const Edge& rhs ) const noexcept
+    {
+        return lhs.from == rhs.from && lhs.to == rhs.to;
+    }
+};
+
+struct getvertices_Edge
+{
+    using str_const_ref = std::reference_wrapper<const std::string>;
+    std::pair<str_const_ref, str_const_ref> operator()( const Edge& t ) const
+    {
+        return std::make_pair( std::cref( t.from ), std::cref( t.to ) );
+    }
+};
+
+struct IdEdge
+{
+    int from;
+    int to;
+};
+
+struct hash_IdEdge
+{
+    size_t operator()( const IdEdge& t )const noexcept
+    {
+        return std::hash<int>()(t.from) ^ (std::hash<int>()(t.to) << 1);
+    }
+};
+
+struct equal_to_IdEdge
+{
+    bool operator()( const IdEdge& lhs, const IdEdge& rhs ) const noexcept
+    {
+        return lhs.from == rhs.from && lhs.to == rhs.to;
+    }
+};
+
+struct getvertices_IdEdge
+{
+    std::pair<int, int> operator()( const IdEdge& t ) const
+    {
+        return std::make_pair( t.from, t.to );
+    }
+};
+
+using graph_t = digraph::digraph<Edge, getvertices_Edge, hash_Edge, equal_to_Edge>;
+using id_graph_t = digraph::digraph<IdEdge, getvertices_IdEdge, hash_IdEdge, equal_to_IdEdge>;
+
+}
+
+
+TEST_CASE( "CSR view contains the adjacency of the graph", "[analytics]" )
+{
+    graph_t g{ { "A", "B" },{ "B","C" } ,{ "C","A" },{ "B","A" } };
+    auto csr = digraph::make_csr_view( g );
+
+    REQUIRE( csr.num_vertices() == 3 );
+    REQUIRE( csr.num_edges() == 4 );
+    REQUIRE( csr.id( "D" ) == csr.num_vertices() );
+
+    const auto a = csr.id( "A" ), b = csr.id( "B" ), c = csr.id( "C" );
+    REQUIRE( csr.vertex( b )->get() == "B" );
+
+    const auto& off = csr.out_offsets();
+    const auto& tgt = csr.out_targets();
+    REQUIRE( off[b + 1] - off[b] == 2 );
+    REQUIRE( std::count( tgt.begin() + off[b], tgt.begin() + off[b + 1], a ) == 1 );
+    REQUIRE( std::count( tgt.begin() + off[b], tgt.begin() + off[b + 1], c ) == 1 );
+
+    const auto& in_off = csr.in_offsets();
+    const auto& src = csr.in_sources();
+    REQUIRE( in_off[a + 1] - in_off[a] == 2 );
+    REQUIRE( in_off[c + 1] - in_off[c] == 1 );
+    REQUIRE( src[in_off[c]] == b );
+}
+
+TEST_CASE( "Degree centrality is the normalized degree of the vertices", "[analytics]" )
+{
+    graph_t g{ { "A", "B" },{ "B","C" } ,{ "C","A" },{ "B","A" } };
+    auto csr = digraph::make_csr_view( g );
+    const auto in = digraph::in_degree_centrality( csr );
+    const auto out = digraph::out_degree_centrality( csr, 2 );
+
+    REQUIRE( in[csr.id( "A" )] == Approx( 1.0 ) );
+    REQUIRE( in[csr.id( "B" )] == Approx( 0.5 ) );
+    REQUIRE( out[csr.id( "B" )] == Approx( 1.0 ) );
+    REQUIRE( out[csr.id( "C" )] == Approx( 0.5 ) );
+}
+
+TEST_CASE( "PageRank of a cycle is uniform", "[analytics]" )
+{
+    id_graph_t g{ { 0, 1 },{ 1, 2 },{ 2, 3 },{ 3, 0 } };
+    auto result = digraph::pagerank( digraph::make_csr_view( g ) );
+
+    REQUIRE( result.iterations >= 1 );
+    REQUIRE( result.residual < 1e-9 );
+    for (auto r : result.rank) REQUIRE( r == Approx( 0.25 ) );
+}
+
+TEST_CASE( "PageRank converges to the same result on multiple threads", "[analytics]" )
+{
+    std::vector<IdEdge> edges;
+    for (int v = 0; v < 200; ++v) {
+        edges.push_back( { v, (v * 7 + 3) % 200 } );
+        edges.push_back( { v, (v * 13 + 1) % 200 } );
+        if (v % 5 == 0) edges.push_back( { (v + 1) % 200, 0 } );
+    }
+    edges.push_back( { 0, 200 } );  // 200 is dangling
+    id_graph_t g( edges.begin(), edges.end() );
+    auto csr = digraph::make_csr_view( g );
+
+    digraph::pagerank_options options;
+    options.threads = 1;
+    const auto single = digraph::pagerank( csr, options );
+    options.threads = 4;
+    const auto multi = digraph::pagerank( csr, options );
+
+    REQUIRE( single.threads == 1 );
+    REQUIRE( multi.threads == 4 );
+    REQUIRE( single.rank.size() == 201 );
+    REQUIRE( std::accumulate( single.rank.begin(), single.rank.end(), 0.0 ) == Approx( 1.0 ) );
+    REQUIRE( single.iterations == multi.iterations );
+    for (size_t v = 0; v < single.rank.size(); ++v) REQUIRE( single.rank[v] == Approx( multi.rank[v] ) );
+    REQUIRE( multi.rank[csr.id( 0 )] > multi.rank[csr.id( 200 )] );
+}
+
+TEST_CASE( "PageRank stops at the iteration cap", "[analytics]" )
+{
+    id_graph_t g{ { 0, 1 },{ 1, 2 },{ 0, 2 } };
+    digraph::pagerank_options options;
+    options.max_iterations = 3;
+    options.tolerance = 0.0;
+    auto result = digraph::pagerank( digraph::make_csr_view( g ), options );
+
+    REQUIRE( result.iterations == 3 );
+    REQUIRE( std::accumulate( result.rank.begin(), result.rank.end(), 0.0 ) == Approx( 1.0 ) );
+}
+
+TEST_CASE( "Weakly connected components ignore the direction of the edges", "[analytics]" )
+{
+    id_graph_t g{ { 0, 1 },{ 2, 1 },{ 3, 4 },{ 5, 4 },{ 4, 3 },{ 6, 6 } };
+    auto csr = digraph::make_csr_view( g );
+    auto result = digraph::weakly_connected_components( csr );
+
+    REQUIRE( result.component.size() == 7 );
+    REQUIRE( result.sizes.size() == 3 );
+    REQUIRE( result.component[csr.id( 0 )] == result.component[csr.id( 2 )] );
+    REQUIRE( result.component[csr.id( 3 )] == result.component[csr.id( 5 )] );
+    REQUIRE( result.component[csr.id( 0 )] != result.component[csr.id( 3 )] );
+    REQUIRE( result.component[csr.id( 6 )] != result.component[csr.id( 0 )] );
+    REQUIRE( result.component[csr.id( 6 )] != result.component[csr.id( 3 )] );
+
+    REQUIRE( result.sizes[result.component[csr.id( 1 )]] == 3 );
+    REQUIRE( result.sizes[result.component[csr.id( 4 )]] == 3 );
+    REQUIRE( result.sizes[result.component[csr.id( 6 )]] == 1 );
+}
+
+TEST_CASE( "Weakly connected components are the same on multiple threads", "[analytics]" )
+{
+    std::vector<IdEdge> edges;
+    for (int island = 0; island < 10; ++island) {
+        for (int v = 0; v < 99; ++v) {
+            edges.push_back( { island * 100 + (v * 37) % 100, island * 100 + ((v + 1) * 37) % 100 } );
+        }
+    }
+    id_graph_t g( edges.begin(), edges.end() );
+    auto csr = digraph::make_csr_view( g );
+
+    const auto single = digraph::weakly_connected_components( csr, 1 );
+    const auto multi = digraph::weakly_connected_components( csr, 8 );
+
+    REQUIRE( single.threads == 1 );
+    REQUIRE( multi.threads == 8 );
+    REQUIRE( single.sizes.size() == 10 );
+    REQUIRE( single.sizes == multi.sizes );
+    REQUIRE( single.component == multi.component );
+    for (auto size : multi.sizes) REQUIRE( size == 100 );
+    for (int v = 0; v < 1000; ++v) {
+        REQUIRE( multi.component[csr.id( v )] == multi.component[csr.id( v - v % 100 )] );
+    }
+}
+
+TEST_CASE( "PageRank uses at most one thread per vertex", "[analytics]" )
+{
+    id_graph_t g{ { 0, 1 },{ 1, 2 },{ 2, 0 },{ 2, 3 } };
+    auto csr = digraph::make_csr_view( g );
+
+    digraph::pagerank_options options;
+    const auto reference = digraph::pagerank( csr, options );
+    options.threads = 1000;
+    const auto result = digraph::pagerank( csr, options );
+
+    REQUIRE( result.threads == 4 );
+    REQUIRE( result.iterations == reference.iterations );
+    for (size_t v = 0; v < result.rank.size(); ++v) REQUIRE( result.rank[v] == Approx( reference.rank[v] ) );
+}
+
+TEST_CASE( "CSR view numbers compact dense vertex ids by the ids themselves", "[analytics]" )
+{
+    id_graph_t g{ { 3, 0 },{ 0, 1 },{ 1, 2 },{ 2, 0 } };
+    auto csr = digraph::make_csr_view( g );
+
+    for (int v = 0; v < 4; ++v) {
+        REQUIRE( csr.id( v ) == static_cast<size_t>(v) );
+        REQUIRE( *csr.vertex( v ) == v );
+    }
+    REQUIRE( csr.id( 4 ) == csr.num_vertices() );
+    REQUIRE( csr.id( -1 ) == csr.num_vertices() );
+
+    const auto in = digraph::in_degree_centrality( csr );
+    REQUIRE( in[0] == Approx( 2.0 / 3.0 ) );
+    REQUIRE( in[3] == Approx( 0.0 ) );
+}
+
+TEST_CASE( "CSR view falls back to enumeration for dense vertex ids with gaps", "[analytics]" )
+{
+    id_graph_t g{ { 0, 5 },{ 5, 7 } };
+    auto csr = digraph::make_csr_view( g );
+
+    REQUIRE( csr.num_vertices() == 3 );
+    REQUIRE( csr.id( 5 ) < csr.num_vertices() );
+    REQUIRE( *csr.vertex( csr.id( 7 ) ) == 7 );
+    REQUIRE( csr.id( 1 ) == csr.num_vertices() );
+}
@@ -1,5 +1,7 @@
 #include <string>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 
 #include "catch.hpp"
 
@@ -255,3 +257,312 @@ TEST_CASE( "DiGraph (getter_by_value) is swappable", "[digraph]" )
 }
 
 
+
+
+struct IntEdge
+{
+    int from;
+    int to;
+};
+
+struct hash_IntEdge
+{
+    size_t operator()( const IntEdge& t )const noexcept
+    {
+        return std::hash<int>()(t.from) ^ (std::hash<int>()(t.to) << 1);
+    }
+};
+
+struct equal_to_IntEdge
+{
+    bool operator()( const IntEdge& lhs, const IntEdge& rhs ) const noexcept
+    {
+        return lhs.from == rhs.from && lhs.to == rhs.to;
+    }
+};
+
+struct getvertices_IntEdge
+{
+    std::pair<int, int> operator()( const IntEdge& t ) const
+    {
+        return std::make_pair( t.from, t.to );
+    }
+};
+
+struct getvertices_by_ref_IntEdge
+{
+    using int_const_ref = std::reference_wrapper<const int>;
+    std::pair<int_const_ref, int_const_ref> operator()( const IntEdge& t ) const
+    {
+        return std::make_pair( std::cref( t.from ), std::cref( t.to ) );
+    }
+};
+
+struct DenseId
+{
+    unsigned id;
+    bool operator==( const DenseId& other ) const noexcept { return id == other.id; }
+};
+
+struct DenseIdEdge
+{
+    DenseId from;
+    DenseId to;
+};
+
+struct hash_DenseId
+{
+    size_t operator()( const DenseId& t )const noexcept
+    {
+        return std::hash<unsigned>()(t.id);
+    }
+};
+
+struct hash_DenseIdEdge
+{
+    size_t operator()( const DenseIdEdge& t )const noexcept
+    {
+        return std::hash<unsigned>()(t.from.id) ^ (std::hash<unsigned>()(t.to.id) << 1);
+    }
+};
+
+struct equal_to_DenseIdEdge
+{
+    bool operator()( const DenseIdEdge& lhs, const DenseIdEdge& rhs ) const noexcept
+    {
+        return lhs.from == rhs.from && lhs.to == rhs.to;
+    }
+};
+
+struct getvertices_DenseIdEdge
+{
+    std::pair<DenseId, DenseId> operator()( const DenseIdEdge& t ) const
+    {
+        return std::make_pair( t.from, t.to );
+    }
+};
+
+namespace digraph
+{
+template<>
+struct dense_vertex_traits<DenseId>
+{
+    using is_dense = std::true_type;
+    static size_t index( const DenseId& t ) noexcept { return t.id; }
+};
+}
+
+struct hash_mod10
+{
+    size_t operator()( int t )const noexcept
+    {
+        return std::hash<int>()(t % 10);
+    }
+};
+
+struct equal_to_mod10
+{
+    bool operator()( int lhs, int rhs ) const noexcept
+    {
+        return lhs % 10 == rhs % 10;
+    }
+};
+
+using digraph_int_t = digraph::digraph<IntEdge, getvertices_IntEdge, hash_IntEdge, equal_to_IntEdge>;
+using digraph_int_mod10_t = digraph::digraph<IntEdge, getvertices_IntEdge, hash_IntEdge, equal_to_IntEdge, hash_mod10, equal_to_mod10>;
+using digraph_int_by_ref_t = digraph::digraph<IntEdge, getvertices_by_ref_IntEdge, hash_IntEdge, equal_to_IntEdge>;
+using digraph_dense_id_t = digraph::digraph<DenseIdEdge, getvertices_DenseIdEdge, hash_DenseIdEdge, equal_to_DenseIdEdge, hash_DenseId>;
+
+
+TEST_CASE( "DiGraph (integral vertices) created from elems contains the edges and vertices that it was created from", "[digraph]" )
+{
+    digraph_int_t g{ { 0, 1 },{ 1, 2 } ,{ 2, 0 },{ 1, 0 } };
+
+    REQUIRE( g.vertices().size() == 3 );
+
+    REQUIRE( g.find( 0 ) != g.vertices().end() );
+    REQUIRE( *g.find( 1 ) == 1 );
+    REQUIRE( g.find( 2 ) != g.vertices().end() );
+    REQUIRE( g.find( 3 ) == g.vertices().end() );
+    REQUIRE( g.find( 100 ) == g.vertices().end() );
+
+    REQUIRE( g.find( 0, 1 ) != g.edges().end() );
+    REQUIRE( g.find( 1, 2 ) != g.edges().end() );
+    REQUIRE( g.find( 1, 0 ) != g.edges().end() );
+    REQUIRE( g.find( 2, 0 ) != g.edges().end() );
+    REQUIRE( g.find( 0, 2 ) == g.edges().end() );
+    REQUIRE( g.find( 3, 0 ) == g.edges().end() );
+    REQUIRE( g.find( 0, 100 ) == g.edges().end() );
+
+    REQUIRE( g.find( 1, 2 )->from == 1 );
+    REQUIRE( g.find( 1, 2 )->to == 2 );
+}
+
+TEST_CASE( "DiGraph (integral vertices by reference) created from elems contains the edges and vertices that it was created from", "[digraph]" )
+{
+    digraph_int_by_ref_t g{ { 0, 1 },{ 1, 2 } ,{ 2, 0 },{ 1, 0 } };
+
+    REQUIRE( g.vertices().size() == 3 );
+    REQUIRE( g.find( 2 ) != g.vertices().end() );
+    REQUIRE( g.find( 3 ) == g.vertices().end() );
+    REQUIRE( g.find( 2, 0 ) != g.edges().end() );
+    REQUIRE( g.find( 0, 2 ) == g.edges().end() );
+}
+
+TEST_CASE( "DiGraph (integral vertices) copy, move, swap and comparison work", "[digraph]" )
+{
+    digraph_int_t g_a{ { 0, 1 },{ 1, 2 } ,{ 2, 0 },{ 1, 0 } };
+    digraph_int_t g_b{ { 0, 1 },{ 1, 2 } ,{ 2, 0 } };
+    digraph_int_t g_a_copy = g_a;
+    REQUIRE( g_a == g_a_copy );
+    REQUIRE( g_a != g_b );
+
+    digraph_int_t g_c = std::move( g_a_copy );
+    REQUIRE( g_c == g_a );
+    REQUIRE( g_c.find( 1, 0 ) != g_c.edges().end() );
+
+    using digraph::swap;
+    swap( g_c, g_b );
+    REQUIRE( g_b == g_a );
+    REQUIRE( g_c.find( 1, 0 ) == g_c.edges().end() );
+
+    g_c = g_a;
+    REQUIRE( g_c == g_a );
+}
+
+TEST_CASE( "DiGraph (user declared dense vertex ids) created from elems contains the edges and vertices that it was created from", "[digraph]" )
+{
+    digraph_dense_id_t g{ { { 0 }, { 1 } },{ { 1 }, { 2 } } };
+
+    REQUIRE( g.vertices().size() == 3 );
+    REQUIRE( g.find( DenseId{ 1 } ) != g.vertices().end() );
+    REQUIRE( g.find( DenseId{ 3 } ) == g.vertices().end() );
+    REQUIRE( g.find( DenseId{ 0 }, DenseId{ 1 } ) != g.edges().end() );
+    REQUIRE( g.find( DenseId{ 1 }, DenseId{ 0 } ) == g.edges().end() );
+
+    digraph_dense_id_t g_copy = g;
+    REQUIRE( g_copy == g );
+}
+
+TEST_CASE( "DiGraph reserve pre-sizes the tables and keeps the graph intact", "[digraph]" )
+{
+    digraph_t g{ { "A", "B" },{ "B","C" } ,{ "C","A" },{ "B","A" } };
+    digraph_t g_copy = g;
+    g.reserve( 1000, 500, 8 );
+
+    REQUIRE( g.edges().bucket_count() * g.edges().max_load_factor() >= 1000 );
+    REQUIRE( g.vertices().bucket_count() * g.vertices().max_load_factor() >= 500 );
+    REQUIRE( g == g_copy );
+    REQUIRE( g.find( "B", "A" ) != g.edges().end() );
+    REQUIRE( g.find( "B", "A" )->from == "B" );
+
+    g.shrink_to_fit();
+    REQUIRE( g.edges().bucket_count() < 1000 );
+    REQUIRE( g.vertices().bucket_count() < 500 );
+    REQUIRE( g == g_copy );
+    REQUIRE( g.find( "C", "A" ) != g.edges().end() );
+}
+
+TEST_CASE( "DiGraph (integral vertices) reserve and shrink_to_fit keep the graph intact", "[digraph]" )
+{
+    digraph_int_t g{ { 0, 1 },{ 1, 2 } ,{ 2, 0 },{ 1, 0 } };
+    digraph_int_t g_copy = g;
+    g.reserve( 1000, 500, 8 );
+    REQUIRE( g == g_copy );
+    g.shrink_to_fit();
+    REQUIRE( g == g_copy );
+    REQUIRE( g.find( 1, 0 ) != g.edges().end() );
+}
+
+TEST_CASE( "DiGraph max load factor is applied to all tables and survives copies", "[digraph]" )
+{
+    digraph_t g{ { "A", "B" },{ "B","C" } ,{ "C","A" },{ "B","A" } };
+    digraph_t g_copy = g;
+    REQUIRE( g.max_load_factor() == Approx( 1.0f ) );
+
+    g.max_load_factor( 0.25f );
+    REQUIRE( g.max_load_factor() == Approx( 0.25f ) );
+    REQUIRE( g.edges().max_load_factor() == Approx( 0.25f ) );
+    REQUIRE( g.vertices().max_load_factor() == Approx( 0.25f ) );
+    REQUIRE( g == g_copy );
+
+    digraph_t g_b = g;
+    REQUIRE( g_b.max_load_factor() == Approx( 0.25f ) );
+    g_copy = g;
+    REQUIRE( g_copy.max_load_factor() == Approx( 0.25f ) );
+}
+
+TEST_CASE( "DiGraph (integral vertices) handles negative vertex ids", "[digraph]" )
+{
+    digraph_int_t g{ { -1, 2 },{ 2, -5 } ,{ 0, 2 } };
+
+    REQUIRE( g.vertices().size() == 4 );
+    REQUIRE( g.find( -1 ) != g.vertices().end() );
+    REQUIRE( *g.find( -5 ) == -5 );
+    REQUIRE( g.find( -2 ) == g.vertices().end() );
+    REQUIRE( g.find( -1, 2 ) != g.edges().end() );
+    REQUIRE( g.find( 2, -5 ) != g.edges().end() );
+    REQUIRE( g.find( 2, -1 ) == g.edges().end() );
+
+    digraph_int_t g_copy = g;
+    REQUIRE( g_copy == g );
+}
+
+TEST_CASE( "DiGraph (integral vertices) handles sparse large vertex ids", "[digraph]" )
+{
+    digraph_int_t g{ { 1000000000, 2 },{ 2, 3 } };
+
+    REQUIRE( g.vertices().size() == 3 );
+    REQUIRE( g.find( 1000000000 ) != g.vertices().end() );
+    REQUIRE( g.find( 999999999 ) == g.vertices().end() );
+    REQUIRE( g.find( 1000000000, 2 ) != g.edges().end() );
+    REQUIRE( g.find( 2, 1000000000 ) == g.edges().end() );
+
+    digraph_int_t g_copy = g;
+    REQUIRE( g_copy == g );
+    REQUIRE( g_copy != digraph_int_t{ { 1000000000, 2 } } );
+}
+
+TEST_CASE( "DiGraph (integral vertices) lookup of absent vertices returns end", "[digraph]" )
+{
+    digraph_int_t g{ { 0, 1 },{ 2, 1 } };
+
+    REQUIRE( g.find( -1 ) == g.vertices().end() );
+    REQUIRE( g.find( 3 ) == g.vertices().end() );
+    REQUIRE( g.find( -1, 1 ) == g.edges().end() );
+    REQUIRE( g.find( 0, -1 ) == g.edges().end() );
+    REQUIRE( g.find( 1, 0 ) == g.edges().end() );
+    REQUIRE( g.find( 100, 0 ) == g.edges().end() );
+}
+
+TEST_CASE( "DiGraph (integral vertices) honors a custom vertex equality", "[digraph]" )
+{
+    digraph_int_mod10_t g{ { 1, 2 },{ 2, 3 } };
+
+    REQUIRE( g.vertices().size() == 3 );
+    REQUIRE( g.find( 11 ) != g.vertices().end() );
+    REQUIRE( *g.find( 11 ) == 1 );
+    REQUIRE( g.find( 14 ) == g.vertices().end() );
+    REQUIRE( g.find( 11, 12 ) != g.edges().end() );
+    REQUIRE( g.find( 11, 12 )->from == 1 );
+    REQUIRE( g.find( 12, 11 ) == g.edges().end() );
+
+    digraph_int_mod10_t g_copy = g;
+    REQUIRE( g_copy == g );
+}
+
+TEST_CASE( "DiGraph rejects a non-positive max load factor without changing the graph", "[digraph]" )
+{
+    digraph_t g{ { "A", "B" },{ "B","C" } ,{ "C","A" },{ "B","A" } };
+    digraph_t g_copy = g;
+    g.max_load_factor( 0.5f );
+
+    REQUIRE_THROWS_AS( g.max_load_factor( 0.0f ), std::invalid_argument );
+    REQUIRE_THROWS_AS( g.max_load_factor( -1.0f ), std::invalid_argument );
+    REQUIRE_THROWS_AS( g.max_load_factor( std::numeric_limits<float>::quiet_NaN() ), std::invalid_argument );
+
+    REQUIRE( g.max_load_factor() == Approx( 0.5f ) );
+    REQUIRE( g.edges().max_load_factor() == Approx( 0.5f ) );
+    REQUIRE( g.vertices().max_load_factor() == Approx( 0.5f ) );
+    REQUIRE( g == g_copy );
+}